@@ -9,14 +9,56 @@
 #ifndef _ORM_BUF_H_
 #define _ORM_BUF_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <vector>
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+#ifdef ORMBUF_ENABLE_STATS
+#include <chrono>
+#include <map>
+#endif
 
 namespace nsOrmBuf {
 
+#ifdef ORMBUF_ENABLE_STATS
+/**
+ * @brief statistics of one registered field
+ *
+ * Fields are identified by their registration path: the index of the reg_ele/reg_arr call
+ * inside init_buf, followed by the index inside the elements for fields registered inside reg_arr,
+ * e.g. {1, 2} is the third field of the elements of the second top-level field.
+ * Paths sort in registration order.
+ */
+struct FieldStat {
+    std::string name;          // field name given at registration, may be empty
+    bool isArr = false;        // registered by reg_arr
+    uint64_t count = 0;        // number of values encoded/decoded
+    uint64_t arrEleCount = 0;  // number of array elements, reg_arr only
+    uint64_t headBytes = 0;    // length header bytes, for reg_arr the size field
+    uint64_t payloadBytes = 0; // payload bytes, for reg_arr the whole element subtree
+    uint64_t nanoseconds = 0;  // encode/decode time, top-level reg_arr only
+};
+
+/**
+ * @brief statistics collected by OrmBuf when ORMBUF_ENABLE_STATS is defined
+ */
+struct Stats {
+    std::map<std::vector<uint32_t>, FieldStat> fields; // per field statistics, key is the registration path
+    uint64_t headBytes = 0;                  // total length header bytes
+    uint64_t payloadBytes = 0;               // total payload bytes
+};
+#endif
+
 /**
  * @brief Base class implementation for OrmBuf.
  *
@@ -42,6 +84,10 @@ public:
      */
     bool encode(T &_t, std::vector<uint8_t> &_distBuf) {
         m_bEnc = true;
+        m_distVec.clear();
+#ifdef ORMBUF_ENABLE_STATS
+        stat_begin();
+#endif
         auto ret = init_buf(_t);
         _distBuf = m_distVec;
         return ret;
@@ -55,9 +101,175 @@ public:
     bool decode(std::vector<uint8_t> &_srcBuf, T &_t) {
         m_bEnc = false;
         m_inBuf = _srcBuf.data();
+#ifdef ORMBUF_ENABLE_STATS
+        stat_begin();
+#endif
         return init_buf(_t);
     }
 
+    /**
+     * @brief overwrite a fixed-width field of an encoded buffer in place, without decoding it
+     *
+     * The field is addressed by its path: the index of the reg_ele/reg_arr call inside init_buf,
+     * followed, for every reg_arr on the way, by the element index and the field index inside the element.
+     * e.g. for OrmBufCompany, {1, 0, 2, 1, 3} is departments[0].employees[1].salary.
+     *
+     * @tparam VT number type, must be the registered type of the field
+     * @param _buf encoded buffer
+     * @param _path field path
+     * @param _value new value
+     * @return true/false, false if the path does not exist or the field type differs
+     */
+    template <typename VT>
+    bool patch(std::vector<uint8_t> &_buf, const std::vector<uint32_t> &_path, const VT &_value) {
+        static_assert(std::is_arithmetic<VT>::value, "only number fields can be patched");
+        T t;
+        walk_begin(_buf);
+        m_patchBuf = _buf.data();
+        m_patchPath = &_path;
+        m_patchType = &typeid(VT);
+        m_patchVal = (const uint8_t *)&_value;
+        init_buf(t);
+        m_bWalk = false;
+        return m_walkFound;
+    }
+
+    /**
+     * @brief transcode an encoded buffer to compact json, without decoding it
+     *
+     * Object keys are the names given to reg_ele/reg_arr, unnamed fields use their registration index.
+     *
+     * @param _srcBuf encoded buffer
+     * @param _json json text is appended to it
+     * @return true/false, false if the buffer is truncated (_json is then incomplete)
+     *         or has bytes left after the last registered field
+     */
+    bool to_json(const std::vector<uint8_t> &_srcBuf, std::string &_json) {
+        T t;
+        walk_begin(_srcBuf);
+        m_jsonOut = &_json;
+        _json.reserve(_json.size() + _srcBuf.size() * 2);
+        _json += '{';
+        init_buf(t);
+        json_close('}');
+        m_bWalk = false;
+        return !m_walkDone && m_inBuf == m_inEnd;
+    }
+
+    /**
+     * @brief 64-bit content hash of an encoded buffer (xxHash64)
+     *
+     * Byte-identical encodings have equal hashes. This is not value equality for float/double fields:
+     * +0.0 and -0.0 compare equal but encode differently, NaN encodes identically but is not equal to itself.
+     *
+     * @param _buf encoded buffer
+     * @param _seed hash seed
+     * @return uint64_t
+     */
+    static uint64_t hash(const std::vector<uint8_t> &_buf, uint64_t _seed = 0) {
+        const uint64_t p1 = 11400714785074694791ULL;
+        const uint64_t p2 = 14029467366897019727ULL;
+        const uint64_t p3 = 1609587929392839161ULL;
+        const uint64_t p4 = 9650029242287828579ULL;
+        const uint64_t p5 = 2870177450012600261ULL;
+        const uint8_t *ptr = _buf.data();
+        const uint8_t *end = ptr + _buf.size();
+        uint64_t h;
+        if (_buf.size() >= 32) {
+            // four independent lanes over 32 byte stripes
+            uint64_t v[4] = {_seed + p1 + p2, _seed + p2, _seed, _seed - p1};
+            for (; ptr + 32 <= end; ptr += 32) {
+                for (int i = 0; i < 4; i++) {
+                    v[i] = hash_round(v[i], read64(ptr + i * 8));
+                }
+            }
+            h = rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18);
+            for (int i = 0; i < 4; i++) {
+                h ^= hash_round(0, v[i]);
+                h = h * p1 + p4;
+            }
+        }
+        else {
+            h = _seed + p5;
+        }
+        h += _buf.size();
+        for (; ptr + 8 <= end; ptr += 8) {
+            h ^= hash_round(0, read64(ptr));
+            h = rotl(h, 27) * p1 + p4;
+        }
+        if (ptr + 4 <= end) {
+            uint32_t k;
+            memcpy(&k, ptr, sizeof(k));
+            h ^= k * p1;
+            h = rotl(h, 23) * p2 + p3;
+            ptr += 4;
+        }
+        for (; ptr < end; ptr++) {
+            h ^= *ptr * p5;
+            h = rotl(h, 11) * p1;
+        }
+        h ^= h >> 33;
+        h *= p2;
+        h ^= h >> 29;
+        h *= p3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    /**
+     * @brief check whether two encoded buffers are byte-identical
+     *
+     * This is not value equality for float/double fields, see hash.
+     *
+     * @return true/false
+     */
+    static bool is_equal(const std::vector<uint8_t> &_buf1, const std::vector<uint8_t> &_buf2) {
+        return _buf1.size() == _buf2.size() && memcmp(_buf1.data(), _buf2.data(), _buf1.size()) == 0;
+    }
+
+#ifdef ORMBUF_ENABLE_STATS
+    /**
+     * @brief get statistics, accumulated over all encode/decode calls since the last reset_stats
+     */
+    const Stats &get_stats() const { return m_stats; }
+
+    /**
+     * @brief clear statistics
+     */
+    void reset_stats() {
+        m_stats = Stats();
+        m_statSlots.clear();
+    }
+
+    /**
+     * @brief dump statistics to string, one field per line
+     *
+     * @return std::string
+     */
+    std::string dump_stats() const {
+        std::stringstream ss;
+        ss << "head:" << m_stats.headBytes << ", payload:" << m_stats.payloadBytes << std::endl;
+        for (auto &it : m_stats.fields) {
+            auto &fs = it.second;
+            for (size_t i = 0; i < it.first.size(); i++) {
+                ss << (i ? "." : "") << it.first[i];
+            }
+            ss << (fs.name.empty() ? "" : " ") << fs.name << (fs.isArr ? " arr" : " ele") << " {";
+            ss << "count:" << fs.count << ", ";
+            if (fs.isArr) {
+                ss << "elements:" << fs.arrEleCount << ", ";
+            }
+            ss << "head:" << fs.headBytes << ", ";
+            ss << "payload:" << fs.payloadBytes;
+            if (fs.nanoseconds) {
+                ss << ", ns:" << fs.nanoseconds;
+            }
+            ss << "}" << std::endl;
+        }
+        return ss.str();
+    }
+#endif
+
     /**
      * @brief dump buffer to hex string
      * 
@@ -101,10 +313,11 @@ protected:
          * @tparam T base c++ type
                     number type, std::string type
          * @param _value 
+         * @param _name field name, optional, used by to_json and statistics
          */
         template <typename ET>
-        void reg_ele(ET &_value) {
-            return m_orm->reg_ele(_value);
+        void reg_ele(ET &_value, const char *_name = nullptr) {
+            return m_orm->reg_ele(_value, _name);
         };
         /**
          * @brief register array
@@ -114,10 +327,11 @@ protected:
          *          void(OrmBuf::ArrReg &eleReg, T* ele);
          * @param _value  array
          * @param regFunc array element register function
+         * @param _name field name, optional, used by to_json and statistics
          */
         template <typename ET, typename F>
-        void reg_arr(ET &_value, F regFunc) {
-            return m_orm->reg_arr(_value, regFunc);
+        void reg_arr(ET &_value, F regFunc, const char *_name = nullptr) {
+            return m_orm->reg_arr(_value, regFunc, _name);
         }
 
     private:
@@ -129,9 +343,16 @@ protected:
      * @tparam T base c++ type
                 number type, std::string type
      * @param _value 
+     * @param _name field name, optional, used by to_json and statistics
      */
     template <typename ET>
-    void reg_ele(ET &_value) {
+    void reg_ele(ET &_value, const char *_name = nullptr) {
+        if (m_bWalk) {
+            return walk_ele(_value, _name);
+        }
+#ifdef ORMBUF_ENABLE_STATS
+        StatScope scope(this, false, _name);
+#endif
         if (m_bEnc) {
             do_encode_num(_value);
         }
@@ -148,25 +369,405 @@ protected:
                 void(OrmBuf::ArrReg &eleReg, ET& ele);
      * @param _value  array
      * @param regFunc array element register function
+     * @param _name field name, optional, used by to_json and statistics
      */
     template <typename ET, typename F>
-    void reg_arr(ET &_value, F regFunc) {
+    void reg_arr(ET &_value, F regFunc, const char *_name = nullptr) {
+        if (m_bWalk) {
+            return walk_arr(_value, regFunc, _name);
+        }
+#ifdef ORMBUF_ENABLE_STATS
+        StatScope scope(this, true, _name);
+#endif
         auto sizeArr = _value.size();
-        reg_ele(sizeArr);
-        using ElementType = typename ET::value_type;
+        if (m_bEnc) {
+            do_encode_num(sizeArr);
+        }
+        else {
+            do_decode_num(sizeArr);
+        }
+#ifdef ORMBUF_ENABLE_STATS
+        scope.set_head(sizeArr);
+#endif
         if (!m_bEnc) {
-            for (decltype(sizeArr) i = 0; i < sizeArr; i++) {
-                ElementType ele_tmp;
-                _value.push_back(ele_tmp);
-            }
+            // construct all elements at once, a std::vector allocates exactly once
+            _value.resize(_value.size() + sizeArr);
         }
         ArrReg arrRegCtx(this);
         for (auto &_ele : _value) {
+#ifdef ORMBUF_ENABLE_STATS
+            m_statNext.back() = 0;
+#endif
             regFunc(arrRegCtx, _ele);
         }
     }
 
 private:
+    struct EleInfo {
+        uint32_t l;
+    };
+#ifdef ORMBUF_ENABLE_STATS
+    /**
+     * @brief records the statistics of one reg_ele/reg_arr call
+     */
+    class StatScope {
+    public:
+        StatScope(OrmBuf *_orm, bool _isArr, const char *_name) : m_orm(_orm), m_isArr(_isArr) {
+            m_fs = m_orm->stat_slot(_isArr, _name);
+            m_pos = m_orm->stat_pos();
+            if (m_isArr) {
+                m_topLevel = m_orm->m_statNext.size() == 1;
+                m_pathLen = m_orm->m_statPath.size();
+                m_orm->stat_enter();
+                // read the clock last, the bookkeeping above is not part of the measured time
+                if (m_topLevel) {
+                    m_start = std::chrono::steady_clock::now();
+                }
+            }
+        }
+        ~StatScope() {
+            std::chrono::steady_clock::time_point end;
+            if (m_topLevel) {
+                end = std::chrono::steady_clock::now();
+            }
+            auto bytes = m_orm->stat_pos() - m_pos;
+            auto &fs = *m_fs;
+            fs.count++;
+            if (m_isArr) {
+                m_orm->stat_leave(m_pathLen);
+                fs.arrEleCount += m_eleCount;
+                fs.headBytes += m_headBytes;
+                fs.payloadBytes += bytes - m_headBytes;
+                if (m_topLevel) {
+                    fs.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count();
+                }
+            }
+            else {
+                fs.headBytes += sizeof(EleInfo);
+                fs.payloadBytes += bytes - sizeof(EleInfo);
+                m_orm->m_stats.headBytes += sizeof(EleInfo);
+                m_orm->m_stats.payloadBytes += bytes - sizeof(EleInfo);
+            }
+        }
+        /**
+         * @brief record the size field of an array, called after it is encoded/decoded
+         */
+        void set_head(size_t _eleCount) {
+            m_eleCount = _eleCount;
+            m_headBytes = m_orm->stat_pos() - m_pos;
+            m_orm->m_stats.headBytes += m_headBytes;
+        }
+
+    private:
+        OrmBuf *m_orm;
+        FieldStat *m_fs;
+        bool m_isArr;
+        bool m_topLevel = false;
+        size_t m_pathLen = 0;
+        size_t m_pos;
+        size_t m_eleCount = 0;
+        size_t m_headBytes = 0;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    void stat_begin() {
+        m_statPath.clear();
+        m_statNext.assign(1, 0);
+        m_statSlots.resize(1);
+        m_statSlots[0].clear();
+        m_statInBase = m_inBuf;
+    }
+
+    /**
+     * @brief get the statistics of the next registered field at the current nesting level
+     *
+     * The map is only searched while the first element of an array registers its fields,
+     * the following elements reuse the cached slots.
+     */
+    FieldStat *stat_slot(bool _isArr, const char *_name) {
+        auto level = m_statNext.size() - 1;
+        auto idx = m_statNext.back()++;
+        auto &slots = m_statSlots[level];
+        if (idx < slots.size()) {
+            return slots[idx];
+        }
+        m_statPath.push_back(idx);
+        auto &fs = m_stats.fields[m_statPath];
+        m_statPath.pop_back();
+        fs.isArr = _isArr;
+        if (_name && fs.name.empty()) {
+            fs.name = _name;
+        }
+        slots.push_back(&fs);
+        return &fs;
+    }
+
+    /**
+     * @brief enter the elements of the array registered last
+     */
+    void stat_enter() {
+        auto level = m_statNext.size() - 1;
+        m_statPath.push_back(m_statNext.back() - 1);
+        m_statNext.push_back(0);
+        if (m_statSlots.size() <= level + 1) {
+            m_statSlots.resize(level + 2);
+        }
+        m_statSlots[level + 1].clear();
+    }
+
+    void stat_leave(size_t _pathLen) {
+        m_statNext.pop_back();
+        m_statPath.resize(_pathLen);
+    }
+    size_t stat_pos() const { return m_bEnc ? m_distVec.size() : m_inBuf - m_statInBase; }
+#endif
+    void walk_begin(const std::vector<uint8_t> &_buf) {
+        m_bEnc = false;
+        m_bWalk = true;
+        m_walkDone = false;
+        m_walkFound = false;
+        m_inBuf = _buf.data();
+        m_inBase = _buf.data();
+        m_inEnd = _buf.data() + _buf.size();
+        m_walkPath.clear();
+        m_walkNext.assign(1, 0);
+        m_patchPath = nullptr;
+        m_jsonOut = nullptr;
+    }
+
+    /**
+     * @brief walk a registered element of an encoded buffer without materializing it
+     */
+    template <typename ET>
+    void walk_ele(ET &, const char *_name) {
+        if (m_walkDone) {
+            return;
+        }
+        OrmBuf::EleInfo einfo;
+        if (!walk_head(einfo)) {
+            return;
+        }
+        m_walkPath.push_back(m_walkNext.back()++);
+        if (m_jsonOut) {
+            json_key(_name);
+            json_val((ET *)nullptr, m_inBuf, einfo.l);
+            *m_jsonOut += ',';
+        }
+        else if (m_walkPath == *m_patchPath) {
+            if (typeid(ET) == *m_patchType && einfo.l == sizeof(ET)) {
+                memcpy(m_patchBuf + (m_inBuf - m_inBase), m_patchVal, sizeof(ET));
+                m_walkFound = true;
+            }
+            m_walkDone = true;
+        }
+        m_walkPath.pop_back();
+        m_inBuf += einfo.l;
+    }
+
+    /**
+     * @brief walk a registered array of an encoded buffer, elements are walked through one placeholder
+     */
+    template <typename ET, typename F>
+    void walk_arr(ET &, F regFunc, const char *_name) {
+        if (m_walkDone) {
+            return;
+        }
+        OrmBuf::EleInfo einfo;
+        typename ET::size_type sizeArr = 0;
+        if (!walk_head(einfo) || einfo.l != sizeof(sizeArr)) {
+            m_walkDone = true;
+            return;
+        }
+        memcpy(&sizeArr, m_inBuf, sizeof(sizeArr));
+        m_inBuf += einfo.l;
+        m_walkPath.push_back(m_walkNext.back()++);
+        if (m_jsonOut) {
+            json_key(_name);
+            *m_jsonOut += '[';
+        }
+        m_walkNext.push_back(0);
+        typename ET::value_type ele;
+        ArrReg arrRegCtx(this);
+        for (decltype(sizeArr) i = 0; i < sizeArr && !m_walkDone; i++) {
+            m_walkPath.push_back(i);
+            m_walkNext.back() = 0;
+            if (m_jsonOut) {
+                *m_jsonOut += '{';
+            }
+            regFunc(arrRegCtx, ele);
+            if (m_jsonOut) {
+                json_close('}');
+                *m_jsonOut += ',';
+            }
+            m_walkPath.pop_back();
+        }
+        m_walkNext.pop_back();
+        m_walkPath.pop_back();
+        if (m_jsonOut) {
+            json_close(']');
+            *m_jsonOut += ',';
+        }
+    }
+
+    /**
+     * @brief close a json object/array, replacing the trailing separator
+     */
+    void json_close(char _c) {
+        auto &out = *m_jsonOut;
+        if (out.back() == ',') {
+            out.back() = _c;
+        }
+        else {
+            out += _c;
+        }
+    }
+
+    void json_key(const char *_name) {
+        auto &out = *m_jsonOut;
+        out += '"';
+        if (_name) {
+            json_escape(_name, strlen(_name));
+        }
+        else {
+            json_uint(m_walkPath.back());
+        }
+        out += "\":";
+    }
+
+    void json_escape(const char *_str, size_t _len) {
+        static const char hexDigits[] = "0123456789abcdef";
+        auto &out = *m_jsonOut;
+        const char *end = _str + _len;
+        while (_str < end) {
+            // copy runs of plain characters at once
+            const char *run = _str;
+            while (run < end && (uint8_t)*run >= 0x20 && *run != '"' && *run != '\\') {
+                run++;
+            }
+            out.append(_str, run);
+            if (run == end) {
+                break;
+            }
+            char c = *run;
+            out += '\\';
+            switch (c) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '\n': out += 'n'; break;
+            case '\r': out += 'r'; break;
+            case '\t': out += 't'; break;
+            default:
+                out += "u00";
+                out += hexDigits[(uint8_t)c >> 4];
+                out += hexDigits[(uint8_t)c & 0xf];
+            }
+            _str = run + 1;
+        }
+    }
+
+    void json_uint(uint64_t _v) {
+        char tmpBuf[20];
+        char *p = tmpBuf + sizeof(tmpBuf);
+        do {
+            *--p = '0' + _v % 10;
+            _v /= 10;
+        } while (_v);
+        m_jsonOut->append(p, tmpBuf + sizeof(tmpBuf));
+    }
+
+    /**
+     * @brief write a json value, overloaded on the registered type
+     */
+    void json_val(std::string *, const uint8_t *_data, uint32_t _len) {
+        *m_jsonOut += '"';
+        json_escape((const char *)_data, _len);
+        *m_jsonOut += '"';
+    }
+    void json_val(bool *, const uint8_t *_data, uint32_t _len) {
+        *m_jsonOut += (_len && *_data) ? "true" : "false";
+    }
+    template <typename ET>
+    void json_val(ET *, const uint8_t *_data, uint32_t _len) {
+        ET v;
+        if (_len != sizeof(v)) {
+            *m_jsonOut += "null";
+            return;
+        }
+        memcpy(&v, _data, sizeof(v));
+        json_num(v, std::is_integral<ET>(), std::is_floating_point<ET>());
+    }
+    template <typename ET>
+    void json_num(ET _v, std::true_type, std::false_type) {
+        if (_v < 0) {
+            *m_jsonOut += '-';
+            // negate in unsigned to cover the minimum value
+            json_uint(0 - (uint64_t)_v);
+        }
+        else {
+            json_uint((uint64_t)_v);
+        }
+    }
+    template <typename ET>
+    void json_num(ET _v, std::false_type, std::true_type) {
+        if (_v != _v || _v - _v != 0) {
+            // nan and inf are not valid json
+            *m_jsonOut += "null";
+            return;
+        }
+#ifdef __cpp_lib_to_chars
+        // shortest round-trip form, independent of the locale
+        char tmpBuf[64];
+        auto res = std::to_chars(tmpBuf, tmpBuf + sizeof(tmpBuf), _v);
+        m_jsonOut->append(tmpBuf, res.ptr);
+#else
+        char tmpBuf[32];
+        int len = snprintf(tmpBuf, sizeof(tmpBuf), "%.*g", sizeof(ET) > sizeof(float) ? 17 : 9, (double)_v);
+        m_jsonOut->append(tmpBuf, len);
+#endif
+    }
+    template <typename ET>
+    void json_num(const ET &_v, std::false_type, std::false_type) {
+        // other trivially copyable types, as hex string
+        static const char hexDigits[] = "0123456789abcdef";
+        auto &out = *m_jsonOut;
+        const uint8_t *p = (const uint8_t *)&_v;
+        out += '"';
+        for (size_t i = 0; i < sizeof(_v); i++) {
+            out += hexDigits[p[i] >> 4];
+            out += hexDigits[p[i] & 0xf];
+        }
+        out += '"';
+    }
+
+    /**
+     * @brief read an element header while walking, stops the walk at the end of the buffer
+     */
+    bool walk_head(EleInfo &_einfo) {
+        if (m_inEnd - m_inBuf < (ptrdiff_t)sizeof(EleInfo)) {
+            m_walkDone = true;
+            return false;
+        }
+        memcpy(&_einfo, m_inBuf, sizeof(EleInfo));
+        if ((size_t)(m_inEnd - m_inBuf) - sizeof(EleInfo) < _einfo.l) {
+            m_walkDone = true;
+            return false;
+        }
+        m_inBuf += sizeof(EleInfo);
+        return true;
+    }
+
+    static uint64_t rotl(uint64_t _x, int _r) { return (_x << _r) | (_x >> (64 - _r)); }
+    static uint64_t read64(const uint8_t *_ptr) {
+        uint64_t v;
+        memcpy(&v, _ptr, sizeof(v));
+        return v;
+    }
+    static uint64_t hash_round(uint64_t _acc, uint64_t _input) {
+        _acc += _input * 14029467366897019727ULL;
+        _acc = rotl(_acc, 31);
+        return _acc * 11400714785074694791ULL;
+    }
+
     template <typename ET>
     void do_encode_num(const ET &_value) {
         auto &outvec = m_distVec;
@@ -178,9 +779,9 @@ private:
     template <typename ET>
     void do_decode_num(ET &_value) {
         auto &inptr = m_inBuf;
-        OrmBuf::EleInfo *einfo = (OrmBuf::EleInfo *)inptr;
+        const OrmBuf::EleInfo *einfo = (const OrmBuf::EleInfo *)inptr;
         inptr += sizeof(OrmBuf::EleInfo);
-        _value = *(ET *)inptr;
+        _value = *(const ET *)inptr;
         inptr += einfo->l;
     }
 
@@ -194,17 +795,34 @@ private:
 
     void do_decode_num(std::string &_value) {
         auto &inptr = m_inBuf;
-        OrmBuf::EleInfo *einfo = (OrmBuf::EleInfo *)inptr;
+        const OrmBuf::EleInfo *einfo = (const OrmBuf::EleInfo *)inptr;
         inptr += sizeof(OrmBuf::EleInfo);
         _value.assign((char *)inptr, einfo->l);
         inptr += einfo->l;
     }
     bool m_bEnc = false;
-    uint8_t *m_inBuf = nullptr;
+    const uint8_t *m_inBuf = nullptr;
     std::vector<uint8_t> m_distVec;
-    struct EleInfo {
-        uint32_t l;
-    };
+    // walk state, see patch and to_json
+    bool m_bWalk = false;
+    bool m_walkDone = false;
+    bool m_walkFound = false;
+    const uint8_t *m_inBase = nullptr;
+    const uint8_t *m_inEnd = nullptr;
+    uint8_t *m_patchBuf = nullptr; // writable start of the buffer being patched
+    std::vector<uint32_t> m_walkPath; // path of the field being walked
+    std::vector<uint32_t> m_walkNext; // index of the next registered field at each nesting level
+    const std::vector<uint32_t> *m_patchPath = nullptr;
+    const std::type_info *m_patchType = nullptr;
+    const uint8_t *m_patchVal = nullptr;
+    std::string *m_jsonOut = nullptr;
+#ifdef ORMBUF_ENABLE_STATS
+    Stats m_stats;
+    std::vector<uint32_t> m_statPath; // registration path of the enclosing array element
+    std::vector<uint32_t> m_statNext; // index of the next registered field at each nesting level
+    std::vector<std::vector<FieldStat *>> m_statSlots; // cached statistics of the fields at each nesting level
+    const uint8_t *m_statInBase = nullptr;  // start of the decode buffer
+#endif
 };
 } // namespace nsOrmBuf
 #endif
\ No newline at end of file
@@ -280,10 +280,189 @@ void main_test_ormBuf() {
     printf("encode and decode : %s\n", are_dat_equal(dat, decDat) ? "equal" : "not equal");
 }
 
+/**
+ * @brief Test hashing and in place patching of encoded buffers.
+ *
+ * Patches departments[0].employees[1].salary of an encoded Company, then checks that decoding
+ * the patched buffer gives the same result as encoding the modified object.
+ */
+void main_test_ormBuf_patch() {
+    Company company;
+    make_test_data_company(company);
+
+    std::vector<uint8_t> seralizeBuf;
+    {
+        OrmBufCompany ormbufCompany;
+        ormbufCompany.encode(company, seralizeBuf);
+    }
+    auto hashOrg = OrmBufCompany::hash(seralizeBuf);
+
+    std::vector<uint8_t> emptyBuf;
+    bool ok = OrmBufCompany::hash(emptyBuf) == 0xef46db3751d8e999ULL;
+
+    // an encoder instance can be reused, the same object gives the same buffer
+    {
+        OrmBufCompany ormbufCompany;
+        std::vector<uint8_t> buf1, buf2;
+        ormbufCompany.encode(company, buf1);
+        ormbufCompany.encode(company, buf2);
+        ok = ok && OrmBufCompany::is_equal(buf1, buf2) && OrmBufCompany::is_equal(buf1, seralizeBuf);
+        ok = ok && OrmBufCompany::hash(buf1) == OrmBufCompany::hash(buf2);
+    }
+
+    float salary = 12345.5;
+    OrmBufCompany ormbufCompany;
+    ok = ok && ormbufCompany.patch(seralizeBuf, {1, 0, 2, 1, 3}, salary);
+    // wrong type, not a leaf, out of range
+    ok = ok && !ormbufCompany.patch(seralizeBuf, {1, 0, 2, 1, 3}, (double)salary);
+    ok = ok && !ormbufCompany.patch(seralizeBuf, {1, 0, 2}, (uint32_t)0);
+    ok = ok && !ormbufCompany.patch(seralizeBuf, {1, 1, 0}, (uint32_t)0);
+
+    company.departments.front().employees[1].salary = salary;
+    std::vector<uint8_t> expectBuf;
+    {
+        OrmBufCompany ormbufCompany;
+        ormbufCompany.encode(company, expectBuf);
+    }
+    ok = ok && OrmBufCompany::is_equal(seralizeBuf, expectBuf);
+    ok = ok && OrmBufCompany::hash(seralizeBuf) == OrmBufCompany::hash(expectBuf);
+    ok = ok && OrmBufCompany::hash(seralizeBuf) != hashOrg;
+
+    Company decCompany;
+    ormbufCompany.decode(seralizeBuf, decCompany);
+    ok = ok && are_companies_equal(company, decCompany);
+
+    printf("------------------------------------\n");
+    printf("patch : %s\n", ok ? "ok" : "error");
+}
+
+/**
+ * @brief Test transcoding encoded buffers to json.
+ */
+void main_test_ormBuf_json() {
+    Company company;
+    make_test_data_company(company);
+    company.departments.push_back(Department());
+    company.departments.back().id = 2;
+    company.departments.back().name = "quote\" backslash\\ tab\t";
+
+    std::vector<uint8_t> seralizeBuf;
+    OrmBufCompany ormbufCompany;
+    ormbufCompany.encode(company, seralizeBuf);
 
+    std::string json;
+    const std::vector<uint8_t> &constBuf = seralizeBuf;
+    bool ok = ormbufCompany.to_json(constBuf, json);
+#ifdef __cpp_lib_to_chars
+    // std::to_chars, shortest round-trip form
+    std::string salary1 = "99999.1", salary2 = "99999.2";
+#else
+    // snprintf("%.9g")
+    std::string salary1 = "99999.1016", salary2 = "99999.2031";
+#endif
+    std::string expect = "{\"name\":\"nb_company\",\"departments\":["
+                         "{\"id\":1,\"name\":\"nb_department\",\"employees\":["
+                         "{\"id\":1007,\"name\":\"nb_employee\",\"age\":35,\"salary\":" + salary1 + "},"
+                         "{\"id\":1008,\"name\":\"nb_employee2\",\"age\":36,\"salary\":" + salary2 + "}]},"
+                         "{\"id\":2,\"name\":\"quote\\\" backslash\\\\ tab\\t\",\"employees\":[]}]}";
+    ok = ok && json == expect;
+
+    // unnamed fields use their registration index, trailing bytes and a truncated buffer fail
+    std::vector<uint8_t> datBuf;
+    Dat dat;
+    OrmBufDat ormbufDat;
+    ormbufDat.encode(dat, datBuf);
+    std::string datJson;
+    ok = ok && ormbufDat.to_json(datBuf, datJson);
+    ok = ok && datJson == "{\"0\":0,\"1\":0,\"2\":0,\"3\":0,\"4\":0,\"5\":0,\"6\":\"\",\"7\":[],\"8\":[]}";
+    std::vector<uint8_t> junkBuf = seralizeBuf;
+    junkBuf.insert(junkBuf.end(), 5, 0xee);
+    std::string junkJson;
+    ok = ok && !ormbufCompany.to_json(junkBuf, junkJson);
+    seralizeBuf.pop_back();
+    std::string truncJson;
+    ok = ok && !ormbufCompany.to_json(seralizeBuf, truncJson);
+
+    printf("------------------------------------\n");
+    printf("json :\n%s\n", json.c_str());
+    printf("json : %s\n", ok ? "ok" : "error");
+}
+
+/**
+ * @brief Test that decoding allocates each std::vector once, with the exact element count.
+ */
+void main_test_ormBuf_reserve() {
+    Company company;
+    make_test_data_company(company);
+    auto &employees = company.departments.front().employees;
+    for (uint32_t i = 0; i < 1000; i++) {
+        employees.push_back(employees.front());
+        employees.back().id = i;
+    }
+
+    std::vector<uint8_t> seralizeBuf;
+    OrmBufCompany ormbufCompany;
+    ormbufCompany.encode(company, seralizeBuf);
+
+    Company decCompany;
+    ormbufCompany.decode(seralizeBuf, decCompany);
+    auto &decEmployees = decCompany.departments.front().employees;
+    bool ok = are_companies_equal(company, decCompany);
+    ok = ok && decEmployees.capacity() == decEmployees.size();
+
+    printf("------------------------------------\n");
+    printf("reserve : %s\n", ok ? "ok" : "error");
+}
+
+#ifdef ORMBUF_ENABLE_STATS
+/**
+ * @brief Test the per field statistics collected by OrmBuf.
+ *
+ * Encodes and decodes a Company object and checks that both directions account for every
+ * byte of the serialized buffer.
+ */
+void main_test_ormBuf_stats() {
+    Company company;
+    make_test_data_company(company);
+    // a second department, its employees reuse the cached statistics of the first one
+    company.departments.push_back(company.departments.front());
+    company.departments.back().employees.pop_back();
+
+    std::vector<uint8_t> seralizeBuf;
+    OrmBufCompany encOrm;
+    encOrm.encode(company, seralizeBuf);
+    auto &encStats = encOrm.get_stats();
+
+    Company decCompany;
+    OrmBufCompany decOrm;
+    decOrm.decode(seralizeBuf, decCompany);
+    auto &decStats = decOrm.get_stats();
+
+    printf("------------------------------------\n");
+    printf("encode stats :\n%s\n", encOrm.dump_stats().c_str());
+
+    bool ok = encStats.headBytes + encStats.payloadBytes == seralizeBuf.size();
+    ok = ok && decStats.headBytes + decStats.payloadBytes == seralizeBuf.size();
+    // {1, 2, 1} is Employee::name
+    ok = ok && encStats.fields.at({1, 2, 1}).count == 3 && encStats.fields.at({1, 2, 1}).name == "name";
+    ok = ok && encStats.fields.at({1, 2, 1}).payloadBytes == 2 * company.departments.front().employees[0].name.size() +
+                                                           company.departments.front().employees[1].name.size();
+    ok = ok && encStats.fields.at({1}).arrEleCount == 2 && decStats.fields.at({1, 2}).arrEleCount == 3;
+    ok = ok && encStats.fields.at({1, 2}).count == 2 && decStats.fields.size() == 9;
+
+    printf("------------------------------------\n");
+    printf("stats : %s\n", ok ? "ok" : "error");
+}
+#endif
 
 int main() {
     main_ormbuf_example();
+    main_test_ormBuf_patch();
+    main_test_ormBuf_json();
+    main_test_ormBuf_reserve();
+#ifdef ORMBUF_ENABLE_STATS
+    main_test_ormBuf_stats();
+#endif
     return 0;
 }
 
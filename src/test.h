@@ -73,20 +73,20 @@ class OrmBufCompany : public nsOrmBuf::OrmBuf<Company> {
 private:
     virtual bool init_buf(Company &company) override {
         // register structure elements
-        reg_ele(company.name);
+        reg_ele(company.name, "name");
         // register structure array elements
         reg_arr(company.departments, [](OrmBuf::ArrReg &arrReg, Department &department) {
             // register structure elements
-            arrReg.reg_ele(department.id);
-            arrReg.reg_ele(department.name);
+            arrReg.reg_ele(department.id, "id");
+            arrReg.reg_ele(department.name, "name");
             // register structure array elements
             arrReg.reg_arr(department.employees, [](OrmBuf::ArrReg &arrReg, Employee &employee) {
-                arrReg.reg_ele(employee.id);
-                arrReg.reg_ele(employee.name);
-                arrReg.reg_ele(employee.age);
-                arrReg.reg_ele(employee.salary);
-            });
-        });
+                arrReg.reg_ele(employee.id, "id");
+                arrReg.reg_ele(employee.name, "name");
+                arrReg.reg_ele(employee.age, "age");
+                arrReg.reg_ele(employee.salary, "salary");
+            }, "employees");
+        }, "departments");
         return true;
     }
 };
@@ -231,6 +231,20 @@ private:
 // ormBuf test entry
 void main_test_ormBuf();
 
+// ormBuf hash and patch test entry
+void main_test_ormBuf_patch();
+
+// ormBuf json test entry
+void main_test_ormBuf_json();
+
+// ormBuf decode allocation test entry
+void main_test_ormBuf_reserve();
+
+#ifdef ORMBUF_ENABLE_STATS
+// ormBuf statistics test entry
+void main_test_ormBuf_stats();
+#endif
+
 // ormBuf example entry
 void main_ormbuf_example();
 